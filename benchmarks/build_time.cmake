@@ -0,0 +1,155 @@
+# Compares how long it takes to build translation units which include
+# ctap.hpp against ones which import the pnk.ctap module, from scratch and
+# after changing one of them. Needs a compiler and generator which support
+# modules, see PNK_CTAP_BUILD_MODULE in the top-level CMakeLists.txt:
+#     cmake -DGENERATOR=Ninja -DCXX=clang++-17 -P benchmarks/build_time.cmake
+# UNITS sets the number of translation units (20), JOBS the number of them
+# compiled at once (1) and MODULE=OFF only times the header.
+cmake_minimum_required(VERSION 3.28)
+
+set(source    ${CMAKE_CURRENT_LIST_DIR}/..)
+set(directory ${CMAKE_CURRENT_BINARY_DIR}/pnk-ctap-build-time)
+
+if (NOT DEFINED GENERATOR)
+    set(GENERATOR Ninja)
+endif()
+if (NOT DEFINED UNITS)
+    set(UNITS 20)
+endif()
+if (NOT DEFINED JOBS)
+    set(JOBS 1)
+endif()
+if (NOT DEFINED MODULE)
+    set(MODULE ON)
+endif()
+
+set(variants header)
+if (MODULE)
+    list(APPEND variants module)
+endif()
+
+# Every unit has its own parser, so none of them is cheaper than the others.
+# Names from the global module fragment, like std::string_view, aren't visible
+# to importers, so both kinds of unit include <string_view> themselves.
+file(REMOVE_RECURSE ${directory})
+math(EXPR last "${UNITS} - 1")
+
+foreach (variant IN LISTS variants)
+    if (variant STREQUAL header)
+        set(use "#include <pnk/ctap.hpp>")
+    else()
+        set(use "import pnk.ctap;")
+    endif()
+
+    foreach (i RANGE ${last})
+        file(WRITE ${directory}/${variant}/unit_${i}.cpp "#include <string_view>
+${use}
+
+auto parse_${i}(int const argc, char const* const* const argv) -> int
+{
+    auto const parser = pnk::make_ctap<
+        pnk::flag    <\"v\", \"verbose\">,
+        pnk::option  <\"j\", \"jobs\", int>,
+        pnk::option  <\"o\", \"output-${i}\", std::string_view>,
+        pnk::position<\"files\", pnk::argv_span>>();
+
+    return parser.parse(argc, argv).get<\"j\">() + ${i};
+}
+")
+    endforeach()
+
+    file(WRITE ${directory}/${variant}/main.cpp "
+auto parse_0(int argc, char const* const* argv) -> int;
+
+auto main(int const argc, char const* const* const argv) -> int
+{
+    return parse_0(argc, argv);
+}
+")
+endforeach()
+
+file(WRITE ${directory}/CMakeLists.txt "
+cmake_minimum_required(VERSION 3.28)
+project(pnk-ctap-build-time CXX)
+
+add_subdirectory(\"${source}\" pnk-ctap)
+
+file(GLOB header_units header/*.cpp)
+add_executable       (header \${header_units})
+target_link_libraries(header PRIVATE pnk-ctap)
+
+if (PNK_CTAP_BUILD_MODULE)
+    file(GLOB module_units module/*.cpp)
+    add_executable       (module \${module_units})
+    target_link_libraries(module PRIVATE pnk-ctap-module)
+endif()
+")
+
+set(configure_options
+    -G ${GENERATOR}
+    -DCMAKE_BUILD_TYPE=Release
+    -DPNK_CTAP_BUILD_MODULE=${MODULE})
+
+if (DEFINED CXX)
+    list(APPEND configure_options -DCMAKE_CXX_COMPILER=${CXX})
+endif()
+
+execute_process(
+    COMMAND         ${CMAKE_COMMAND} ${configure_options}
+                    -S ${directory} -B ${directory}/build
+    RESULT_VARIABLE exit
+    OUTPUT_QUIET)
+
+if (NOT exit EQUAL 0)
+    message(FATAL_ERROR "Configuring ${directory} failed")
+endif()
+
+# Sets the variable named output to the seconds building target took.
+function(time_build target output)
+    string(TIMESTAMP begin "%s%f")
+
+    execute_process(
+        COMMAND         ${CMAKE_COMMAND} --build ${directory}/build
+                        --target ${target} --parallel ${JOBS}
+        RESULT_VARIABLE exit
+        OUTPUT_QUIET)
+
+    string(TIMESTAMP end "%s%f")
+
+    if (NOT exit EQUAL 0)
+        message(FATAL_ERROR "Building ${target} failed")
+    endif()
+
+    # The timestamps are in microseconds, the result in hundredths.
+    math(EXPR elapsed "(${end} - ${begin}) / 10000")
+    math(EXPR seconds   "${elapsed} / 100")
+    math(EXPR hundredths "${elapsed} % 100")
+
+    if (hundredths LESS 10)
+        set(hundredths 0${hundredths})
+    endif()
+
+    set(${output} ${seconds}.${hundredths} PARENT_SCOPE)
+endfunction()
+
+# From scratch includes building the module itself. After a change, only the
+# changed unit is compiled again and everything is linked.
+message("${UNITS} units, ${JOBS} at a time, in seconds:")
+message("           from scratch    after a change")
+
+foreach (variant IN LISTS variants)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} --build ${directory}/build --target clean
+        OUTPUT_QUIET)
+
+    time_build(${variant} scratch)
+
+    file(TOUCH ${directory}/${variant}/unit_0.cpp)
+    time_build(${variant} change)
+
+    string(LENGTH "${scratch}" padding)
+    math(EXPR padding "16 - ${padding}")
+    string(REPEAT " " ${padding} space)
+
+    message("    ${variant} ${scratch}${space}${change}")
+endforeach()
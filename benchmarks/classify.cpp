@@ -0,0 +1,138 @@
+// Copyright (c) Hrvoje "Hurubon" Žohar
+// See LICENSE for copyright information.
+
+// Compares the single pass which classifies tokens against scanning each of
+// them the way the engine used to, then times whole parses, for command lines
+// of 10, 1000 and 100000 tokens.
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+
+#include <pnk/ctap.hpp>
+
+namespace
+{
+    // A mix of short options with a separate value, wordy options with an
+    // inline value and flags, with values of typical lengths. There are no
+    // positions, since a parser only takes so many of them.
+    auto make_tokens(std::size_t const count) -> std::vector<std::string>
+    {
+        auto constexpr pattern = std::to_array<std::string_view>({
+            "-j",
+            "4",
+            "--output=build/release/bin/application",
+            "--verbose",
+            "-s",
+            "src/pnk/ctap/engine.cpp",
+            "-O",
+            "--define=PNK_CTAP_OPTION_COUNT=100",
+            "-I",
+            "include",
+        });
+
+        auto tokens = std::vector<std::string>{ "benchmark" };
+        for (auto i = std::size_t(0); i < count; ++i)
+            tokens.emplace_back(pattern[i % pattern.size()]);
+
+        return tokens;
+    }
+
+    template <typename Function>
+    auto nanoseconds_per_token(
+        std::vector<char const*> const& argv,
+        Function&&                      function)
+    -> double
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Every size is run over roughly the same number of tokens in total.
+        auto const repetitions = std::max<std::size_t>(
+            10'000'000 / argv.size(),
+            1);
+
+        auto const begin = clock::now();
+        for (auto i = std::size_t(0); i < repetitions; ++i)
+            function(argv);
+        auto const end = clock::now();
+
+        auto const elapsed = std::chrono::duration<double, std::nano>(
+            end - begin);
+
+        return elapsed.count() / double(repetitions * (argv.size() - 1));
+    }
+
+    // Keeps the compiler from throwing away the results.
+    auto volatile sink = std::size_t(0);
+
+    auto classify_scalar(std::vector<char const*> const& argv) -> void
+    {
+        auto sum = std::size_t(0);
+        for (auto i = std::size_t(1); i < argv.size(); ++i)
+        {
+            auto const type = pnk::detail::classify_scalar(argv[i]);
+            sum += type.size + type.equals + type.dashes;
+        }
+
+        sink = sink + sum;
+    }
+
+    auto classify(std::vector<char const*> const& argv) -> void
+    {
+        auto sum = std::size_t(0);
+        for (auto i = std::size_t(1); i < argv.size(); ++i)
+        {
+            auto const type = pnk::detail::classify(argv[i]);
+            sum += type.size + type.equals + type.dashes;
+        }
+
+        sink = sink + sum;
+    }
+
+    auto parse(std::vector<char const*> const& argv) -> void
+    {
+        auto static const parser = pnk::make_ctap<
+            pnk::option<"j", "jobs",    int>,
+            pnk::option<"",  "output",  std::string_view>,
+            pnk::flag  <"",  "verbose">,
+            pnk::option<"s", "source",  std::string_view>,
+            pnk::flag  <"O", "">,
+            pnk::option<"",  "define",  std::string_view>,
+            pnk::option<"I", "include", std::string_view>>();
+
+        auto const result = parser.parse(
+            static_cast<int>(argv.size()),
+            argv.data());
+
+        sink = sink + result.get<"j">();
+    }
+} // namespace
+
+auto main() -> int
+{
+    std::printf("%8s %14s %14s %14s\n",
+        "tokens",
+        "scalar ns/tok",
+        "simd ns/tok",
+        "parse ns/tok");
+
+    for (std::size_t const count : { 10, 1'000, 100'000 })
+    {
+        auto const tokens = make_tokens(count);
+
+        auto argv = std::vector<char const*>{};
+        for (auto const& token : tokens)
+            argv.push_back(token.c_str());
+
+        std::printf("%8zu %14.2f %14.2f %14.2f\n",
+            count,
+            nanoseconds_per_token(argv, classify_scalar),
+            nanoseconds_per_token(argv, classify),
+            nanoseconds_per_token(argv, parse));
+    }
+}
@@ -0,0 +1,55 @@
+// Copyright (c) Hrvoje "Hurubon" Žohar
+// See LICENSE for copyright information.
+
+// Instantiates one parser with PNK_CTAP_OPTION_COUNT options, a third each of
+// them integers, flags and strings, so the size of its machine code can be
+// compared against parsers with a different number of options.
+
+#include <cstddef>
+#include <utility>
+#include <string_view>
+
+#include <pnk/ctap.hpp>
+
+namespace
+{
+    template <std::size_t i>
+    auto constexpr name = []
+    {
+        char digits[] = "option-0000";
+        digits[7]  += i / 1000 % 10;
+        digits[8]  += i / 100  % 10;
+        digits[9]  += i / 10   % 10;
+        digits[10] += i        % 10;
+
+        return pnk::static_string(digits);
+    }();
+
+    template <std::size_t i>
+    using option = std::conditional_t<
+        i % 3 == 0,
+        pnk::option<"", name<i>, int>,
+        std::conditional_t<
+            i % 3 == 1,
+            pnk::flag<"", name<i>>,
+            pnk::option<"", name<i>, std::string_view>>>;
+
+    template <std::size_t... i>
+    auto parse(
+        int                const argc,
+        char const* const* const argv,
+        std::index_sequence<i...>)
+    {
+        auto const parser = pnk::make_ctap<option<i>...>();
+
+        return parser.parse(argc, argv).template get<name<0>>();
+    }
+} // namespace
+
+auto pnk_ctap_code_size(int const argc, char const* const* const argv) -> int
+{
+    return parse(
+        argc,
+        argv,
+        std::make_index_sequence<PNK_CTAP_OPTION_COUNT>{});
+}
@@ -41,7 +41,20 @@
 // arguments are specifically called "position(al argument)s" and
 // options   are specifically called "optional( argument)s".
 
+#include <bit>
+#include <span>
+#include <array>
+#include <limits>
+#include <tuple>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <ranges>
+#include <optional>
+#include <utility>
+#include <iterator>
+#include <algorithm>
 #include <concepts>
 #include <charconv>
 #include <type_traits>
@@ -50,8 +63,221 @@
 #include <pnk/static_string.hpp>
 #include <pnk/type_set.hpp>
 
+// The engine classifies tokens with SSE2 where it's available. Defining
+// PNK_CTAP_DISABLE_SIMD always uses the portable version instead. So do
+// AddressSanitizer and MemorySanitizer: the vectorized version reads past the
+// end of tokens, and branches on whether those bytes are zero.
+#if defined(__has_feature)
+#   if __has_feature(address_sanitizer) or __has_feature(memory_sanitizer)
+#       define PNK_CTAP_SANITIZER
+#   endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#   define PNK_CTAP_SANITIZER
+#endif
+
+#if (defined(__SSE2__) or defined(_M_X64) or defined(_M_AMD64)) and \
+    not defined(PNK_CTAP_DISABLE_SIMD) and                          \
+    not defined(PNK_CTAP_SANITIZER)
+#   define PNK_CTAP_SSE2
+#   include <emmintrin.h>
+#endif
+
 namespace pnk
 {
+    // Some arguments don't stand for a single token, but for a whole run of
+    // them, e.g. all the files in "tool -v file1 file2 file3". Those are
+    // stored as a view over the part of argv they span, so no matter how many
+    // tokens there are, nothing is copied or allocated.
+    using argv_span = std::span<char const* const>;
+
+    // PROBLEM:
+    // A std::string_view argument takes any bytes. Before a value is written
+    // to a log or used as a path it has to be checked, and it's easiest to do
+    // that once, while parsing.
+
+    // Instead of std::string_view, an argument can have the type validated,
+    // which is only parsed if its value passes the given checks:
+    //     .add_optional<"o", "output",
+    //         pnk::validated<pnk::text_check::utf8 | pnk::text_check::path>>()
+    // Otherwise it's handled like any other value which can't be parsed.
+    enum class text_check : unsigned
+    {
+        utf8    = 1u << 0, // Is well-formed UTF-8.
+        control = 1u << 1, // Has no C0, C1 or DEL control characters.
+        path    = 1u << 2, // Has no ".." components, between '/' or '\\'.
+    };
+
+    [[nodiscard]]
+    auto constexpr operator|(
+        pnk::text_check const lhs,
+        pnk::text_check const rhs)
+    noexcept -> pnk::text_check
+    {
+        return pnk::text_check(unsigned(lhs) | unsigned(rhs));
+    }
+
+    template <pnk::text_check checks>
+    struct validated : std::string_view
+    {
+        [[nodiscard]]
+        constexpr validated() noexcept = default;
+        [[nodiscard]]
+        constexpr explicit validated(std::string_view const text) noexcept
+            : std::string_view{ text }
+        {}
+    };
+
+    namespace detail
+    {
+        [[nodiscard]]
+        auto constexpr has_check(
+            pnk::text_check const checks,
+            pnk::text_check const check)
+        noexcept -> bool
+        {
+            return (unsigned(checks) & unsigned(check)) != 0;
+        }
+
+        // Checks the code point which starts at text[i] and returns its size
+        // in bytes, or 0 if it's rejected. Only used for non-ASCII bytes.
+        [[nodiscard]]
+        auto constexpr check_code_point(
+            std::string_view const text,
+            std::size_t      const i,
+            pnk::text_check  const checks)
+        noexcept -> std::size_t
+        {
+            auto const byte = [&](std::size_t const j) -> unsigned
+            {
+                return i + j < text.size()?
+                    static_cast<unsigned char>(text[i + j]) :
+                    0;
+            };
+
+            auto const lead  = byte(0);
+            auto const is_c1 = lead == 0xC2 and byte(1) >= 0x80 and
+                byte(1) <= 0x9F;
+
+            if (detail::has_check(checks, text_check::control) and is_c1)
+                return 0;
+            if (not detail::has_check(checks, text_check::utf8))
+                return 1;
+
+            // The ranges of the second byte exclude overlong encodings,
+            // surrogates and code points past U+10FFFF[3, table 3-7].
+            auto const [size, low, high] =
+                lead >= 0xC2 and lead <= 0xDF? std::array{ 2u, 0x80u, 0xBFu } :
+                lead == 0xE0?                  std::array{ 3u, 0xA0u, 0xBFu } :
+                lead == 0xED?                  std::array{ 3u, 0x80u, 0x9Fu } :
+                lead >= 0xE1 and lead <= 0xEF? std::array{ 3u, 0x80u, 0xBFu } :
+                lead == 0xF0?                  std::array{ 4u, 0x90u, 0xBFu } :
+                lead == 0xF4?                  std::array{ 4u, 0x80u, 0x8Fu } :
+                lead >= 0xF1 and lead <= 0xF3? std::array{ 4u, 0x80u, 0xBFu } :
+                                               std::array{ 0u, 0u,    0u    };
+
+            if (size == 0 or byte(1) < low or byte(1) > high)
+                return 0;
+
+            for (auto j = std::size_t(2); j < size; ++j)
+                if (byte(j) < 0x80 or byte(j) > 0xBF)
+                    return 0;
+
+            return size;
+        }
+
+        [[nodiscard]]
+        auto constexpr is_control(char const c) noexcept -> bool
+        {
+            return static_cast<unsigned char>(c) < 0x20 or c == 0x7F;
+        }
+
+        [[nodiscard]]
+        auto constexpr is_separator(char const c) noexcept -> bool
+        {
+            return c == '/' or c == '\\';
+        }
+
+        // The ASCII bytes of a value are checked 16 at a time where SSE2 is
+        // available, while code points outside of ASCII are decoded one by
+        // one. Values are usually mostly ASCII, so that's rare.
+        [[nodiscard]]
+        inline auto is_valid(
+            std::string_view const text,
+            pnk::text_check  const checks)
+        noexcept -> bool
+        {
+            auto const control = detail::has_check(checks, text_check::control);
+            auto i = std::size_t(0);
+
+            while (i < text.size())
+            {
+#if defined(PNK_CTAP_SSE2)
+                auto const space = _mm_set1_epi8(0x20);
+                auto const del   = _mm_set1_epi8(0x7F);
+
+                for (; i + 16 <= text.size(); i += 16)
+                {
+                    auto const bytes = _mm_loadu_si128(
+                        reinterpret_cast<__m128i const*>(text.data() + i));
+
+                    // Bytes from 0x80 are negative, so they are less than 0x20.
+                    auto const high     = unsigned(_mm_movemask_epi8(bytes));
+                    auto const controls = unsigned(_mm_movemask_epi8(
+                        _mm_or_si128(
+                            _mm_cmplt_epi8(bytes, space),
+                            _mm_cmpeq_epi8(bytes, del)))) & ~high;
+
+                    if (control and controls != 0)
+                        return false;
+
+                    if (high != 0)
+                    {
+                        i += std::countr_zero(high);
+                        break;
+                    }
+                }
+
+                if (i == text.size())
+                    break;
+#endif
+                if (static_cast<unsigned char>(text[i]) < 0x80)
+                {
+                    if (control and detail::is_control(text[i]))
+                        return false;
+
+                    ++i;
+                    continue;
+                }
+
+                auto const size = detail::check_code_point(text, i, checks);
+                if (size == 0)
+                    return false;
+
+                i += size;
+            }
+
+            // std::string_view::find already uses a vectorized search.
+            if (detail::has_check(checks, text_check::path))
+            {
+                for (auto dots = text.find("..");
+                    dots != std::string_view::npos;
+                    dots = text.find("..", dots + 1))
+                {
+                    auto const first = dots == 0 or
+                        detail::is_separator(text[dots - 1]);
+                    auto const last  = dots + 2 == text.size() or
+                        detail::is_separator(text[dots + 2]);
+
+                    if (first and last)
+                        return false;
+                }
+            }
+
+            return true;
+        }
+    } // namespace detail
+
     // See static_string.hpp for more information.
     template <
         pnk::static_string brief_name,
@@ -70,6 +296,22 @@ namespace pnk
         mutable type value;
     };
 
+    // An argument can also be bound to a member of a user-defined aggregate:
+    //     struct config { int jobs; bool verbose; };
+    //     auto parser = pnk::ctap_builder{}
+    //         .add_optional<"j", "jobs",    &config::jobs>()
+    //         .add_optional<"v", "verbose", &config::verbose>();
+    //     auto options = config{};
+    //     parser.parse(argc, argv, options);
+    // The argument's type is the type of the member.
+    template <
+        typename Argument,
+        auto     member_pointer>
+    struct bound_argument : Argument
+    {
+        auto constexpr static member = member_pointer;
+    };
+
     auto constexpr parse_visitor(auto, auto) noexcept -> void = delete; 
 
     template <
@@ -118,36 +360,1203 @@ namespace pnk
         argument.value      = to_parse;
     }
 
-    // See type_set.hpp for more information.
-    // The parser stores arguments in three different sets based on their kind.
-    // This makes lookup easier and more efficient. When parsing is complete,
-    // these sets are merged into one and returned as a ctap_result.
-    template <typename TypeSet>
-    struct ctap_result
-    {
-    public:
+    template <
+        pnk::static_string brief,
+        pnk::static_string wordy,
+        pnk::text_check    checks,
+        bool               needed>
+    auto constexpr parse_visitor(
+        pnk::argument<brief, wordy, pnk::validated<checks>, needed>& argument,
+        std::string_view                                             to_parse)
+    noexcept
+    {
+        if (detail::is_valid(to_parse, checks))
+        {
+            argument.was_parsed = true;
+            argument.value      = pnk::validated<checks>(to_parse);
+        }
+        else
+        {
+            argument.was_parsed = false;
+        }
+    }
+
+    template <
+        pnk::static_string brief,
+        pnk::static_string wordy,
+        bool               needed>
+    auto constexpr parse_visitor(
+        pnk::argument<brief, wordy, pnk::argv_span, needed>& argument,
+        pnk::argv_span                                       to_parse)
+    noexcept
+    {
+        argument.was_parsed = true;
+        argument.value      = to_parse;
+    }
+
+    namespace detail
+    {
+        // Two arguments are the same key if any of their names are the same.
+        // Brief names may be empty, so those are never compared.
+        template <
+            typename Lhs,
+            typename Rhs>
+        struct argument_comparator : std::bool_constant<
+            Lhs::wordy == Rhs::wordy or
+            (not Rhs::brief.empty() and Lhs::wordy == Rhs::brief) or
+            (not Lhs::brief.empty() and Lhs::brief == Rhs::wordy) or
+            (not Lhs::brief.empty() and Lhs::brief == Rhs::brief)>
+        {};
+
+        // By convention, a lone "--" ends the options. Everything after it is
+        // passed through as is, usually to another program. The passthrough
+        // argument is stored with the positions, and since "--" can't be the
+        // brief name of a position, that's what tells it apart from them.
+        template <typename Argument>
+        auto constexpr is_passthrough =
+            std::string_view(Argument::brief) == "--";
+
+        // Both options and "--" start with a hyphen, and either ends a rest.
+        auto constexpr is_hyphenated(char const* const token) noexcept -> bool
+        {
+            return token[0] == '-';
+        }
+
+        template <auto member>
+        struct member_traits;
+
+        template <
+            typename        Class,
+            typename        T,
+            T Class::*      member>
+        struct member_traits<member>
+        {
+            using class_type  = Class;
+            using member_type = T;
+        };
+
+        template <auto member>
+        using member_type = typename member_traits<member>::member_type;
+
+        template <
+            pnk::static_string brief,
+            pnk::static_string wordy,
+            auto               member,
+            bool               needed>
+        using bound_argument = pnk::bound_argument<
+            pnk::argument<brief, wordy, member_type<member>, needed>,
+            member>;
+
+        // Rests and passthroughs are stored with the positions, but they are
+        // told apart from them when the parser's table is made.
+        enum class argument_kind
+        {
+            position,
+            optional,
+            boolean,
+            rest,
+            passthrough,
+        };
+
+        template <typename Tuple>
+        struct type_set_of;
+
+        template <typename... Arguments>
+        struct type_set_of<std::tuple<Arguments...>>
+        {
+            using type = pnk::type_set<argument_comparator, Arguments...>;
+        };
+
+        // Every declaration contributes either its argument or nothing, so a
+        // single pack expansion picks out all the arguments of one kind while
+        // keeping the order in which they were declared. Constraints have no
+        // kind, so they never contribute an argument.
+        template <
+            argument_kind kind,
+            typename      Declaration>
+        struct select_argument : std::type_identity<std::tuple<>>
+        {};
+
+        template <
+            argument_kind kind,
+            typename      Declaration>
+            requires (Declaration::kind == kind)
+        struct select_argument<kind, Declaration>
+            : std::type_identity<std::tuple<typename Declaration::argument>>
+        {};
+
+        template <
+            argument_kind kind,
+            typename...   Declarations>
+        using arguments_of = typename type_set_of<decltype(std::tuple_cat(
+            std::declval<typename select_argument<
+                kind,
+                Declarations>::type>()...))>::type;
+
+        // Likewise for the constraints, which are kept in a tuple of types.
+        template <typename Declaration>
+        struct select_constraint : std::type_identity<std::tuple<>>
+        {};
+
+        template <typename Declaration>
+            requires requires { Declaration::constraint; }
+        struct select_constraint<Declaration>
+            : std::type_identity<std::tuple<Declaration>>
+        {};
+
+        template <typename... Declarations>
+        using constraints_of = decltype(std::tuple_cat(
+            std::declval<typename select_constraint<Declarations>::type>()...));
+    } // namespace detail
+
+    // PROBLEM:
+    // Going through argv and matching names works the same way in every
+    // parser. If it were written in terms of the argument types, every parser
+    // would get its own copy of it, which grows with every argument added.
+
+    // Instead, each parser describes its arguments in a table made at compile-
+    // time, and a single engine, which doesn't depend on any types, looks the
+    // tokens up in it. Only converting a value depends on the argument's type,
+    // so each entry in the table points to a small function which does that.
+
+    // NOTE:
+    // The function depends only on the type of the value, not on the names,
+    // so all arguments of the same type share it. This means parse_visitor is
+    // chosen by the type of the value, which is how it's meant to be extended.
+    namespace detail
+    {
+        using visit_function = auto (*)(
+            void*            value,
+            std::string_view to_parse,
+            pnk::argv_span   span)
+        noexcept -> bool;
+
+        struct descriptor
+        {
+            std::string_view brief;
+            std::string_view wordy;
+            argument_kind    kind;
+            bool             needed;
+            visit_function   visit;
+        };
+
+        // Where the engine stores what it parsed for each argument. If value
+        // is null, the value is checked, but not kept.
+        struct target
+        {
+            void* value;
+            bool* was_parsed;
+        };
+
+        // Calls parse_visitor for an argument of type T and reports whether it
+        // succeeded. The value is only written if it did.
+        template <typename T>
+        auto visit(
+            void*            const value,
+            std::string_view const to_parse,
+            pnk::argv_span   const span)
+        noexcept -> bool
+        {
+            auto argument = pnk::argument<"", "", T, false>{};
+
+            if constexpr (std::is_same_v<T, pnk::argv_span>)
+                pnk::parse_visitor(argument, span);
+            else
+                pnk::parse_visitor(argument, to_parse);
+
+            if (argument.was_parsed and value != nullptr)
+                *static_cast<T*>(value) = std::move(argument.value);
+
+            return argument.was_parsed;
+        }
+
+        // Targets the members of an aggregate which arguments are bound to.
+        // Whether each argument was parsed is written to the same discarded
+        // flag, since the engine keeps track of that itself.
+        template <typename TypeSet>
+        struct bound_targets;
+
+        template <
+            template <
+                typename,
+                typename>
+            typename    Comparator,
+            typename... Arguments>
+        struct bound_targets<pnk::type_set<Comparator, Arguments...>>
+        {
+            template <typename Aggregate>
+            [[nodiscard]]
+            auto constexpr static of(
+                Aggregate& aggregate,
+                bool&      discarded)
+            noexcept
+            {
+                return std::array<target, sizeof...(Arguments)>{
+                    target_of<Arguments>(aggregate, discarded)...};
+            }
+
+        private:
+            template <
+                typename Argument,
+                typename Aggregate>
+            [[nodiscard]]
+            auto constexpr static target_of(
+                Aggregate& aggregate,
+                bool&      discarded)
+            noexcept -> target
+            {
+                if constexpr (requires { Argument::member; })
+                {
+                    using Class = typename detail::member_traits<
+                        Argument::member>::class_type;
+                    static_assert(
+                        std::is_same_v<Class, Aggregate>,
+                        "Argument is bound to a member of another type.");
+
+                    return { &(aggregate.*Argument::member), &discarded };
+                }
+                else
+                {
+                    return { nullptr, &discarded };
+                }
+            }
+        };
+
+        template <
+            argument_kind kind,
+            typename      Argument>
+        [[nodiscard]]
+        auto consteval describe() noexcept -> descriptor
+        {
+            auto const refined =
+                kind != argument_kind::position?
+                    kind :
+                detail::is_passthrough<Argument>?
+                    argument_kind::passthrough :
+                std::is_same_v<typename Argument::type, pnk::argv_span>?
+                    argument_kind::rest :
+                    kind;
+
+            return descriptor{
+                .brief  = Argument::brief,
+                .wordy  = Argument::wordy,
+                .kind   = refined,
+                .needed = Argument::is_needed,
+                .visit  = &detail::visit<typename Argument::type>,
+            };
+        }
+
+        // A rest takes every position from where it starts, so any position
+        // after it could only be given if an option ended the rest first.
+        template <std::size_t size>
+        [[nodiscard]]
+        auto consteval rest_is_last(
+            std::array<descriptor, size> const& descriptors)
+        noexcept -> bool
+        {
+            auto rest_found = false;
+
+            for (auto const& descriptor : descriptors)
+            {
+                if (rest_found and
+                    (descriptor.kind == argument_kind::position or
+                     descriptor.kind == argument_kind::rest))
+                    return false;
+
+                rest_found |= descriptor.kind == argument_kind::rest;
+            }
+
+            return true;
+        }
+
+        template <
+            argument_kind kind,
+            typename      TypeSet>
+        struct descriptors_of;
+
+        template <
+            argument_kind kind,
+            template <
+                typename,
+                typename>
+            typename      Comparator,
+            typename...   Arguments>
+        struct descriptors_of<kind, pnk::type_set<Comparator, Arguments...>>
+        {
+            auto constexpr static value =
+                std::array<descriptor, sizeof...(Arguments)>{
+                    detail::describe<kind, Arguments>()...};
+
+            static_assert(
+                detail::rest_is_last(value),
+                "A rest has to be the last position, and the only rest.");
+        };
+
+        template <std::size_t... sizes>
+        [[nodiscard]]
+        auto consteval concatenate(
+            std::array<descriptor, sizes> const&... tables)
+        noexcept
+        {
+            auto result = std::array<descriptor, (sizes + ... + 0)>{};
+            auto i      = std::size_t(0);
+
+            ((std::copy(tables.begin(), tables.end(), result.begin() + i),
+              i += tables.size()), ...);
+
+            return result;
+        }
+
+        // The engine marks which arguments were parsed in a bitset, one bit
+        // per entry in the table.
+        using word = std::uint64_t;
+
+        auto constexpr word_bits = std::size_t(64);
+        auto constexpr npos      = static_cast<std::size_t>(-1);
+
+        [[nodiscard]]
+        auto constexpr words_for(std::size_t const count) noexcept
+        {
+            return (count + word_bits - 1) / word_bits;
+        }
+
+        auto constexpr mark(
+            std::span<word>   const parsed,
+            std::size_t       const index,
+            bool              const was_parsed)
+        noexcept -> void
+        {
+            auto const bit = word(1) << (index % word_bits);
+
+            if (was_parsed)
+                parsed[index / word_bits] |=  bit;
+            else
+                parsed[index / word_bits] &= ~bit;
+        }
+
+        [[nodiscard]]
+        auto constexpr is_marked(
+            std::span<word const> const parsed,
+            std::size_t           const index)
+        noexcept -> bool
+        {
+            return parsed[index / word_bits] >> (index % word_bits) & 1;
+        }
+
+        [[nodiscard]]
+        inline auto find_optional(
+            std::span<descriptor const> const descriptors,
+            std::string_view            const name,
+            bool                        const wordy)
+        noexcept -> std::size_t
+        {
+            // An empty name would match every optional without a brief name.
+            if (name.empty())
+                return npos;
+
+            for (auto i = std::size_t(0); i < descriptors.size(); ++i)
+            {
+                auto const& d = descriptors[i];
+                if (d.kind != argument_kind::optional and
+                    d.kind != argument_kind::boolean)
+                    continue;
+
+                if ((wordy? d.wordy : d.brief) == name)
+                    return i;
+            }
+
+            return npos;
+        }
+
+        [[nodiscard]]
+        inline auto find_kind(
+            std::span<descriptor const> const descriptors,
+            std::size_t                 const from,
+            argument_kind               const kind)
+        noexcept -> std::size_t
+        {
+            for (auto i = from; i < descriptors.size(); ++i)
+                if (descriptors[i].kind == kind)
+                    return i;
+
+            return npos;
+        }
+
+        // Positions are filled in order, so the next one can be found by
+        // continuing from the previous one.
+        [[nodiscard]]
+        inline auto find_position(
+            std::span<descriptor const> const descriptors,
+            std::size_t                 const from)
+        noexcept -> std::size_t
+        {
+            for (auto i = from; i < descriptors.size(); ++i)
+                if (descriptors[i].kind == argument_kind::position or
+                    descriptors[i].kind == argument_kind::rest)
+                    return i;
+
+            return npos;
+        }
+
+        // PROBLEM:
+        // Telling what a token is takes three scans over its bytes: one to
+        // find its length, since argv only has pointers to its beginning, one
+        // for its leading hyphens and one for the '=' of "--name=value".
+
+        // Instead, all of that is found in a single pass, which looks at 16
+        // bytes at a time where SSE2 is available. The engine does this for
+        // a block of tokens at a time and keeps the results in a small table.
+        struct token_class
+        {
+            std::uint32_t size;
+            std::uint32_t equals; // Index of the first '=', or no_equals.
+            std::uint8_t  dashes; // Number of leading hyphens, at most 2.
+        };
+
+        auto constexpr no_equals  = std::numeric_limits<std::uint32_t>::max();
+        auto constexpr block_size = std::size_t(64);
+
+        [[nodiscard]]
+        auto constexpr dashes_of(
+            std::string_view const token)
+        noexcept -> std::uint8_t
+        {
+            return token.starts_with("--")? 2 : token.starts_with('-');
+        }
+
+        // The version which scans each token the same way the engine used to.
+        [[nodiscard]]
+        inline auto classify_scalar(
+            char const* const token)
+        noexcept -> token_class
+        {
+            auto const view   = std::string_view(token);
+            auto const equals = view.find('=');
+
+            return {
+                .size   = static_cast<std::uint32_t>(view.size()),
+                .equals = equals != std::string_view::npos?
+                    static_cast<std::uint32_t>(equals) :
+                    no_equals,
+                .dashes = detail::dashes_of(view),
+            };
+        }
+
+        [[nodiscard]]
+        inline auto classify(
+            char const* const token)
+        noexcept -> token_class
+        {
+#if defined(PNK_CTAP_SSE2)
+            // Aligned loads never cross a page boundary, so the bytes before
+            // the token and after its terminator can be read, but are ignored.
+            auto const offset  = reinterpret_cast<std::uintptr_t>(token) % 16;
+            auto const zero    = _mm_setzero_si128();
+            auto const equal   = _mm_set1_epi8('=');
+            auto       chunk   = token - offset;
+            auto       ignored = offset;
+            auto       equals  = no_equals;
+
+            for (;; chunk += 16, ignored = 0)
+            {
+                auto const bytes = _mm_load_si128(
+                    reinterpret_cast<__m128i const*>(chunk));
+
+                auto const ends = static_cast<unsigned>(_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(bytes, zero))) >> ignored << ignored;
+                auto const eqs  = static_cast<unsigned>(_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(bytes, equal))) >> ignored << ignored;
+
+                // Only an '=' before the terminator is part of the token.
+                auto const before_end = ends?
+                    (1u << std::countr_zero(ends)) - 1 :
+                    ~0u;
+                if (equals == no_equals and (eqs & before_end))
+                {
+                    equals = static_cast<std::uint32_t>(
+                        chunk - token + std::countr_zero(eqs));
+                }
+
+                if (ends)
+                {
+                    auto const size = static_cast<std::uint32_t>(
+                        chunk - token + std::countr_zero(ends));
+
+                    return {
+                        .size   = size,
+                        .equals = equals,
+                        .dashes = detail::dashes_of({ token, size }),
+                    };
+                }
+            }
+#else
+            return detail::classify_scalar(token);
+#endif
+        }
+
+        // Whether a token is an option, a position or something else depends
+        // only on the tokens before it, so the engine takes them one by one.
+        enum class token_kind
+        {
+            pending,    // An option whose value is the next token.
+            optional,
+            position,
+            terminator, // "--", the index is that of the passthrough, if any.
+            unknown,
+        };
+
+        struct token_match
+        {
+            token_kind       kind;
+            std::size_t      index;
+            std::string_view value;
+        };
+
+        struct tokenizer
+        {
+            std::size_t next_position = 0;
+            std::size_t pending       = npos;
+            std::size_t passthrough   = npos;
+            std::size_t rest          = npos; // The rest taking tokens, if any.
+            bool        options_ended = false;
+        };
+
+        [[nodiscard]]
+        inline auto feed(
+            std::span<descriptor const> const descriptors,
+            tokenizer&                        state,
+            std::string_view            const token,
+            token_class                 const type)
+        noexcept -> token_match
+        {
+            if (state.pending != npos)
+            {
+                auto const index = std::exchange(state.pending, npos);
+                return { token_kind::optional, index, token };
+            }
+
+            // A rest is a single run of tokens, so an option or "--" ends it.
+            if (not state.options_ended and type.dashes != 0 and
+                state.rest != npos)
+            {
+                state.next_position = std::exchange(state.rest, npos) + 1;
+            }
+
+            if (not state.options_ended and type.dashes == 2 and type.size == 2)
+            {
+                state.options_ended = true;
+                state.passthrough   = detail::find_kind(
+                    descriptors,
+                    0,
+                    argument_kind::passthrough);
+
+                return { token_kind::terminator, state.passthrough, token };
+            }
+
+            if (not state.options_ended and type.dashes != 0)
+            {
+                auto const wordy  = type.dashes == 2;
+                auto const offset = std::size_t(wordy) + 1;
+                auto const equals = type.equals != no_equals?
+                    std::size_t(type.equals) :
+                    std::string_view::npos;
+                auto const name   = equals != std::string_view::npos?
+                    token.substr(offset, equals - offset) :
+                    token.substr(offset);
+
+                auto const index = detail::find_optional(
+                    descriptors,
+                    name,
+                    wordy);
+
+                if (index == npos)
+                    return { token_kind::unknown, npos, token };
+                else if (descriptors[index].kind == argument_kind::boolean)
+                    return { token_kind::optional, index, {} };
+                else if (equals != std::string_view::npos)
+                    return {
+                        token_kind::optional,
+                        index,
+                        token.substr(equals + 1)};
+
+                state.pending = index;
+                return { token_kind::pending, index, {} };
+            }
+
+            // Everything after "--" belongs to the passthrough, if there is
+            // one. Otherwise, those tokens are positions.
+            if (state.passthrough != npos)
+                return { token_kind::position, state.passthrough, token };
+
+            auto const index = detail::find_position(
+                descriptors,
+                state.next_position);
+
+            if (index == npos)
+                return { token_kind::unknown, npos, token };
+
+            // A rest takes every position until it's ended.
+            if (descriptors[index].kind != argument_kind::rest)
+                state.next_position = index + 1;
+            else
+                state.rest = index;
+
+            return { token_kind::position, index, token };
+        }
+
+        // For tokens which don't come from argv, and are already sized.
+        [[nodiscard]]
+        inline auto feed(
+            std::span<descriptor const> const descriptors,
+            tokenizer&                        state,
+            std::string_view            const token)
+        noexcept -> token_match
+        {
+            auto const equals = token.find('=');
+            auto const type   = token_class{
+                .size   = static_cast<std::uint32_t>(token.size()),
+                .equals = equals != std::string_view::npos?
+                    static_cast<std::uint32_t>(equals) :
+                    no_equals,
+                .dashes = detail::dashes_of(token),
+            };
+
+            return detail::feed(descriptors, state, token, type);
+        }
+
+        [[nodiscard]]
+        inline auto parse(
+            std::span<descriptor const> const descriptors,
+            std::span<target     const> const targets,
+            std::span<word>             const parsed,
+            int                         const argc,
+            char const* const*          const argv)
+        noexcept -> bool
+        {
+            auto const visit = [&](
+                std::size_t      const index,
+                std::string_view const to_parse,
+                pnk::argv_span   const span)
+            {
+                auto const [value, was_parsed] = targets[index];
+                *was_parsed = descriptors[index].visit(value, to_parse, span);
+
+                detail::mark(parsed, index, *was_parsed);
+            };
+
+            auto const end = argv + argc;
+            auto state = tokenizer{};
+
+            // The classes of the tokens from block_begin up to block_end. A
+            // whole block is classified at once, including tokens which a rest
+            // then takes without looking at them. Only the blocks which a rest
+            // skips entirely aren't classified.
+            auto classes     = std::array<token_class, block_size>{};
+            auto block_begin = argv + 1;
+            auto block_end   = argv + 1;
+
+            for (auto i = argv + 1; i < end; ++i)
+            {
+                if (i >= block_end)
+                {
+                    auto const size = std::min<std::ptrdiff_t>(
+                        end - i,
+                        block_size);
+
+                    block_begin = i;
+                    block_end   = i + size;
+
+                    for (auto j = std::ptrdiff_t(0); j < size; ++j)
+                        classes[j] = detail::classify(i[j]);
+                }
+
+                auto const type  = classes[i - block_begin];
+                auto const token = std::string_view(*i, type.size);
+
+                auto const [kind, index, value] = detail::feed(
+                    descriptors,
+                    state,
+                    token,
+                    type);
+
+                if (kind == token_kind::unknown)
+                {
+                    return false;
+                }
+                else if (kind == token_kind::optional)
+                {
+                    visit(index, value, {});
+                }
+                else if (kind == token_kind::terminator and index != npos)
+                {
+                    visit(index, {}, pnk::argv_span(i + 1, end));
+                    break;
+                }
+                else if (kind == token_kind::position and
+                    descriptors[index].kind == argument_kind::rest)
+                {
+                    // Since argv is at hand, the rest takes all of its tokens
+                    // in one go. The token which ends it is fed as usual.
+                    auto const last = state.options_ended?
+                        end :
+                        std::find_if(i, end, detail::is_hyphenated);
+
+                    visit(index, {}, pnk::argv_span(i, last));
+                    i = last - 1;
+                }
+                else if (kind == token_kind::position)
+                {
+                    visit(index, value, {});
+                }
+            }
+
+            // An option was given without a value.
+            if (state.pending != npos)
+                return false;
+
+            for (auto i = std::size_t(0); i < descriptors.size(); ++i)
+                if (descriptors[i].needed and not detail::is_marked(parsed, i))
+                    return false;
+
+            return true;
+        }
+    } // namespace detail
+
+    // See type_set.hpp for more information.
+    // The parser stores arguments in three different sets based on their kind.
+    // This makes lookup easier and more efficient. When parsing is complete,
+    // these sets are merged into one and returned as a ctap_result.
+    template <typename TypeSet>
+    struct ctap_result
+    {
+    public:
+        [[nodiscard]]
+        constexpr explicit ctap_result(TypeSet&& arguments) noexcept
+            : m_arguments{ std::move(arguments) }
+        {}
+
+        template <pnk::static_string name>
+        [[nodiscard]]
+        auto constexpr get() const noexcept
+        {
+            using Argument = pnk::argument<name, name, void*, false>;
+
+            return m_arguments.template get<Argument>().value;
+        }
+
+    private:
+        TypeSet m_arguments;
+    };
+
+    // PROBLEM:
+    // A server may parse its arguments once and hand the result to many
+    // worker processes, through shared memory or a pipe. If the arguments are
+    // bound to an aggregate of trivially copyable members, its bytes are all
+    // there is to it, so it can be sent as is and read without parsing again.
+
+    // NOTE:
+    // std::string_view and pnk::argv_span members point into argv. They are
+    // only meaningful in processes where argv is at the same address, such as
+    // ones forked after parsing.
+    template <typename Aggregate>
+    [[nodiscard]]
+    auto constexpr serialize(Aggregate const& aggregate) noexcept requires (
+        std::is_trivially_copyable_v<Aggregate>)
+    {
+        using bytes = std::array<std::byte, sizeof(Aggregate)>;
+
+        return std::bit_cast<bytes>(aggregate);
+    }
+
+    template <typename Aggregate>
+    [[nodiscard]]
+    auto deserialize(
+        std::span<std::byte const, sizeof(Aggregate)> bytes)
+    noexcept -> Aggregate requires (
+        std::is_trivially_copyable_v<Aggregate> and
+        std::is_default_constructible_v<Aggregate>)
+    {
+        auto aggregate = Aggregate{};
+        std::memcpy(&aggregate, bytes.data(), sizeof(Aggregate));
+
+        return aggregate;
+    }
+
+    // PROBLEM:
+    // Some arguments only make sense together, or not at all together, e.g.
+    // --daemon and --foreground, or --tls-key without --tls-cert. These are
+    // stated as constraints on the names of the arguments:
+    //     pnk::exclusive   <"daemon", "foreground">
+    //     pnk::at_least_one<"input", "stdin">
+    //     pnk::implies     <"tls-key", "tls-cert">
+    // The names are looked up when the parser is made, so a typo is a compile
+    // error. Each constraint becomes a mask over the bits the engine marks for
+    // parsed arguments, so checking it doesn't involve looking anything up.
+    namespace detail
+    {
+        enum class constraint_kind
+        {
+            exclusive,    // At most one of names.
+            at_least_one, // At least one of names.
+            implies,      // If names, then all of implied.
+        };
+
+        template <std::size_t words>
+        struct constraint_masks
+        {
+            constraint_kind         kind;
+            std::array<word, words> names;
+            std::array<word, words> implied;
+        };
+
+        template <
+            typename           Arguments,
+            pnk::static_string name>
+        [[nodiscard]]
+        auto consteval index_of_name() noexcept -> std::size_t
+        {
+            using Argument = pnk::argument<name, name, void*, false>;
+
+            auto constexpr index = Arguments::template index_of<Argument>();
+            static_assert(
+                index != Arguments::npos,
+                "Constraint refers to an unknown argument.");
+
+            return index;
+        }
+
+        template <
+            typename              Arguments,
+            pnk::static_string... names>
+        [[nodiscard]]
+        auto consteval mask_of() noexcept
+        {
+            auto mask = std::array<word, words_for(Arguments::size)>{};
+            (detail::mark(
+                mask,
+                detail::index_of_name<Arguments, names>(),
+                true), ...);
+
+            return mask;
+        }
+
+        template <
+            typename Arguments,
+            typename Constraints>
+        struct constraint_table;
+
+        template <
+            typename    Arguments,
+            typename... Constraints>
+        struct constraint_table<Arguments, std::tuple<Constraints...>>
+        {
+            using masks = constraint_masks<words_for(Arguments::size)>;
+
+            auto constexpr static value =
+                std::array<masks, sizeof...(Constraints)>{
+                    Constraints::template masks<Arguments>...};
+        };
+
+        [[nodiscard]]
+        inline auto satisfies(
+            constraint_kind       const kind,
+            std::span<word const> const names,
+            std::span<word const> const implied,
+            std::span<word const> const parsed)
+        noexcept -> bool
+        {
+            auto given   = 0;
+            auto missing = false;
+
+            for (auto i = std::size_t(0); i < parsed.size(); ++i)
+            {
+                given   += std::popcount(parsed[i] & names[i]);
+                missing |= (parsed[i] & implied[i]) != implied[i];
+            }
+
+            switch (kind)
+            {
+            case constraint_kind::exclusive:    return given <= 1;
+            case constraint_kind::at_least_one: return given >= 1;
+            case constraint_kind::implies:      return not given or not missing;
+            }
+
+            return false;
+        }
+    } // namespace detail
+
+    // PROBLEM:
+    // parse only returns once every token has been parsed. When the tokens
+    // come from a response file or a pipe, there may be millions of them, and
+    // a program may want to act on each as soon as it's parsed, e.g. enqueue
+    // an input file, rather than wait for all of them.
+
+    // Instead, a parser can turn any range of tokens into a range of events:
+    //     for (auto const& event : parser.events(tokens))
+    //     {
+    //         if (event.is<"files">())
+    //             enqueue(event.token());
+    //         else if (event.is<"jobs">())
+    //             set_jobs(event.get<"jobs">());
+    //     }
+    // Values are converted by the same parse_visitors as in parse. There is
+    // only ever one event, which is overwritten by the next one, so the memory
+    // used doesn't depend on the number of tokens. This also means an event,
+    // and the token it refers to, are only valid until the next one.
+
+    // NOTE:
+    // Since the tokens needn't come from argv, the first one isn't skipped.
+    // Unknown tokens are reported as events instead of failing, and neither
+    // needed arguments nor constraints are checked. A rest or a passthrough
+    // gets an event for each of its tokens, but its value isn't set, so use
+    // the token instead.
+    enum class event_kind
+    {
+        optional,
+        position,
+        unknown,
+        invalid,  // The value couldn't be converted or was missing.
+    };
+
+    template <
+        typename Arguments,
+        typename Tokens>
+    struct ctap_events;
+
+    template <typename Arguments>
+    struct ctap_event
+    {
+    public:
+        [[nodiscard]]
+        auto constexpr kind() const noexcept -> pnk::event_kind
+        {
+            return m_kind;
+        }
+
+        // The value which was parsed. For boolean options and unknown tokens,
+        // this is the whole token.
+        [[nodiscard]]
+        auto constexpr token() const noexcept -> std::string_view
+        {
+            return m_token;
+        }
+
+        template <pnk::static_string name>
+        [[nodiscard]]
+        auto constexpr is() const noexcept -> bool
+        {
+            using Argument = pnk::argument<name, name, void*, false>;
+
+            auto constexpr index = Arguments::template index_of<Argument>();
+            static_assert(index != Arguments::npos, "Cannot find key.");
+
+            return m_index == index;
+        }
+
+        template <pnk::static_string name>
+        [[nodiscard]]
+        auto constexpr get() const noexcept
+        {
+            using Argument = pnk::argument<name, name, void*, false>;
+
+            return m_arguments->template get<Argument>().value;
+        }
+
+    private:
+        template <
+            typename,
+            typename>
+        friend struct pnk::ctap_events;
+
+        pnk::event_kind  m_kind      = pnk::event_kind::unknown;
+        std::size_t      m_index     = detail::npos;
+        std::string_view m_token;
+        Arguments const* m_arguments = nullptr;
+    };
+
+    template <
+        typename Arguments,
+        typename Tokens>
+    struct ctap_events
+    {
+    public:
+        struct iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type       = pnk::ctap_event<Arguments>;
+            using difference_type  = std::ptrdiff_t;
+
+            [[nodiscard]]
+            constexpr iterator() noexcept = default;
+
+            [[nodiscard]]
+            auto operator*() const noexcept -> value_type const&
+            {
+                return m_events->m_event;
+            }
+
+            auto operator++() -> iterator&
+            {
+                m_events->advance();
+                return *this;
+            }
+
+            auto operator++(int) -> void
+            {
+                m_events->advance();
+            }
+
+            [[nodiscard]]
+            friend auto operator==(
+                iterator const& i,
+                std::default_sentinel_t)
+            noexcept -> bool
+            {
+                return i.is_done();
+            }
+
+        private:
+            friend struct ctap_events;
+
+            // operator== is only a friend of the iterator, not of the events.
+            [[nodiscard]]
+            auto constexpr is_done() const noexcept -> bool
+            {
+                return m_events->m_done;
+            }
+
+            [[nodiscard]]
+            constexpr explicit iterator(ctap_events* events) noexcept
+                : m_events{ events }
+            {}
+
+            ctap_events* m_events = nullptr;
+        };
+
         [[nodiscard]]
-        constexpr explicit ctap_result(TypeSet&& arguments) noexcept
-            : m_arguments{ arguments }
+        constexpr ctap_events(
+            std::span<detail::descriptor const> descriptors,
+            Tokens                              tokens)
+            : m_descriptors{ descriptors }
+            , m_tokens     { std::move(tokens) }
         {}
 
-        template <pnk::static_string name>
+        // Events point into this object, so nothing is parsed until begin is
+        // called, after which the object mustn't be moved.
         [[nodiscard]]
-        auto constexpr get() const noexcept
+        auto begin() -> iterator
         {
-            using Argument = pnk::argument<name, name, void*, false>;
+            auto i = std::size_t(0);
+            m_arguments.for_each([&](auto& argument)
+            {
+                m_targets[i++] = { &argument.value, &argument.was_parsed };
+            });
 
-            return m_arguments.template get<Argument>().value;
+            m_current.emplace(std::ranges::begin(m_tokens));
+            m_event.m_arguments = &m_arguments;
+            advance();
+
+            return iterator(this);
+        }
+
+        [[nodiscard]]
+        auto end() const noexcept -> std::default_sentinel_t
+        {
+            return std::default_sentinel;
         }
 
     private:
-        TypeSet const m_arguments;
+        // The current token isn't skipped until the next event is asked for,
+        // since the event may refer to it.
+        auto advance() -> void
+        {
+            using detail::token_kind;
+            using detail::argument_kind;
+
+            auto& current = *m_current;
+            if (std::exchange(m_skip, false))
+                ++current;
+
+            for (; current != std::ranges::end(m_tokens); ++current)
+            {
+                auto const token = std::string_view(*current);
+                auto const [kind, index, value] = detail::feed(
+                    m_descriptors,
+                    m_state,
+                    token);
+
+                if (kind == token_kind::pending or
+                    kind == token_kind::terminator)
+                    continue;
+
+                m_skip          = true;
+                m_event.m_index = index;
+                m_event.m_token = token;
+
+                if (kind == token_kind::unknown)
+                {
+                    m_event.m_kind = pnk::event_kind::unknown;
+                    return;
+                }
+
+                auto const described = m_descriptors[index].kind;
+                if (described == argument_kind::rest or
+                    described == argument_kind::passthrough)
+                {
+                    m_event.m_kind = pnk::event_kind::position;
+                    return;
+                }
+
+                if (described == argument_kind::optional)
+                    m_event.m_token = value;
+
+                auto const [pointer, was_parsed] = m_targets[index];
+                *was_parsed = m_descriptors[index].visit(pointer, value, {});
+
+                if (not *was_parsed)
+                    m_event.m_kind = pnk::event_kind::invalid;
+                else if (kind == token_kind::optional)
+                    m_event.m_kind = pnk::event_kind::optional;
+                else
+                    m_event.m_kind = pnk::event_kind::position;
+
+                return;
+            }
+
+            // The tokens ended with an option which needs a value.
+            if (m_state.pending != detail::npos)
+            {
+                m_event.m_kind  = pnk::event_kind::invalid;
+                m_event.m_index = std::exchange(m_state.pending, detail::npos);
+                m_event.m_token = {};
+                return;
+            }
+
+            m_done = true;
+        }
+
+        // Not every iterator can be default constructed, so there's no
+        // current token until begin is called.
+        using Iterator = std::ranges::iterator_t<Tokens>;
+        using Targets  = std::array<detail::target, Arguments::size>;
+
+        std::span<detail::descriptor const> m_descriptors;
+        Tokens                              m_tokens;
+        std::optional<Iterator>             m_current{};
+        Arguments                           m_arguments{};
+        Targets                             m_targets{};
+        detail::tokenizer                   m_state{};
+        pnk::ctap_event<Arguments>          m_event{};
+        bool                                m_skip = false;
+        bool                                m_done = false;
     };
 
     template <
         typename PositionsTypeSet,
         typename OptionalsTypeSet,
-        typename BooleansTypeSet>
+        typename BooleansTypeSet,
+        typename Constraints = std::tuple<>>
     struct ctap
     {
     public:
@@ -160,7 +1569,30 @@ namespace pnk
             using Argument = pnk::argument<"", name, T, needed>;
             using Inserted = decltype(m_positions.template insert(Argument{}));
             
-            return pnk::ctap<Inserted, OptionalsTypeSet, BooleansTypeSet>{};
+            return rebind<Inserted, OptionalsTypeSet, BooleansTypeSet>{};
+        }
+
+        // A position of type pnk::argv_span is the rest of the positions.
+        // It spans from the first token which isn't assigned to any other
+        // position up to the next option, "--" or the end, so it has to be
+        // the last position, and the only rest, which is checked at compile
+        // time. It's a single run of tokens, and any token after it which
+        // isn't an option is unknown, so options can come before or after it,
+        // but not in the middle of it:
+        //     tool -v a b c    and    tool a b c -v    are fine,
+        //     tool a -v b c                            fails.
+        // The passthrough spans everything after "--". Without one, the
+        // tokens after "--" are positions even if they start with a hyphen,
+        // so the rest can start after "--", but can't continue past it.
+        template <
+            pnk::static_string name,
+            bool               needed = false>
+        auto constexpr add_passthrough() const noexcept
+        {
+            using Argument = pnk::argument<"--", name, pnk::argv_span, needed>;
+            using Inserted = decltype(m_positions.template insert(Argument{}));
+
+            return rebind<Inserted, OptionalsTypeSet, BooleansTypeSet>{};
         }
 
         template <
@@ -174,7 +1606,7 @@ namespace pnk
             using Argument = pnk::argument<brief, wordy, T, needed>;
             using Inserted = decltype(m_optionals.template insert(Argument{}));
             
-            return pnk::ctap<PositionsTypeSet, Inserted, BooleansTypeSet>{};
+            return rebind<PositionsTypeSet, Inserted, BooleansTypeSet>{};
         }
 
         // You don't have to provide a brief name for an optional.
@@ -188,7 +1620,7 @@ namespace pnk
             using Argument = pnk::argument<"", wordy, T, needed>;
             using Inserted = decltype(m_optionals.template insert(Argument{}));
             
-            return pnk::ctap<PositionsTypeSet, Inserted, BooleansTypeSet>{};
+            return rebind<PositionsTypeSet, Inserted, BooleansTypeSet>{};
         }
 
         // Specializations for boolean options.
@@ -203,7 +1635,7 @@ namespace pnk
             using Argument = pnk::argument<brief, wordy, bool, needed>;
             using Inserted = decltype(m_booleans.template insert(Argument{}));
             
-            return pnk::ctap<PositionsTypeSet, OptionalsTypeSet, Inserted>{};
+            return rebind<PositionsTypeSet, OptionalsTypeSet, Inserted>{};
         }
 
         template <
@@ -216,122 +1648,198 @@ namespace pnk
             using Argument = pnk::argument<"", wordy, bool, needed>;
             using Inserted = decltype(m_booleans.template insert(Argument{}));
             
-            return pnk::ctap<PositionsTypeSet, OptionalsTypeSet, Inserted>{};
+            return rebind<PositionsTypeSet, OptionalsTypeSet, Inserted>{};
+        }
+
+        // Overloads for arguments bound to a member of an aggregate.
+        template <
+            pnk::static_string name,
+            auto               member,
+            bool               needed = false>
+        auto constexpr add_position() const noexcept requires (
+            std::is_member_object_pointer_v<decltype(member)>)
+        {
+            using Argument = detail::bound_argument<"", name, member, needed>;
+            using Inserted = decltype(m_positions.template insert(Argument{}));
+
+            return rebind<Inserted, OptionalsTypeSet, BooleansTypeSet>{};
+        }
+
+        template <
+            pnk::static_string brief,
+            pnk::static_string wordy,
+            auto               member,
+            bool               needed = false>
+        auto constexpr add_optional() const noexcept requires (
+            std::is_member_object_pointer_v<decltype(member)>)
+        {
+            using Argument  = detail::bound_argument<
+                brief,
+                wordy,
+                member,
+                needed>;
+            using Optionals = decltype(m_optionals.template insert(Argument{}));
+            using Booleans  = decltype(m_booleans .template insert(Argument{}));
+
+            if constexpr (std::is_same_v<typename Argument::type, bool>)
+                return rebind<PositionsTypeSet, OptionalsTypeSet, Booleans>{};
+            else
+                return rebind<PositionsTypeSet, Optionals, BooleansTypeSet>{};
+        }
+
+        template <
+            pnk::static_string wordy,
+            auto               member,
+            bool               needed = false>
+        auto constexpr add_optional() const noexcept requires (
+            std::is_member_object_pointer_v<decltype(member)>)
+        {
+            return add_optional<"", wordy, member, needed>();
+        }
+
+        template <typename Constraint>
+        auto constexpr add_constraint() const noexcept requires (
+            requires { Constraint::constraint; })
+        {
+            using Inserted = decltype(std::tuple_cat(
+                std::declval<Constraints>(),
+                std::declval<std::tuple<Constraint>>()));
+
+            return pnk::ctap<
+                PositionsTypeSet,
+                OptionalsTypeSet,
+                BooleansTypeSet,
+                Inserted>{};
         }
 
         [[nodiscard]]
-        auto constexpr parse(
+        auto parse(
             int                const argc,
             char const* const* const argv)
-        noexcept
+        const noexcept
         {
-            for (auto i = argv + 1; i < argv + argc; ++i)
-            {
-                auto current = std::string_view(*i);
+            return pnk::ctap_result(parse_arguments(argc, argv));
+        }
 
-                if (current.starts_with("--"))
-                    i += parse_optional<true >(current, i + 1);
-                else if (current.starts_with('-'))
-                    i += parse_optional<false>(current, i + 1);
-                else
-                    parse_position(current);
-            }
+        template <std::ranges::input_range Tokens>
+        [[nodiscard]]
+        auto events(Tokens&& tokens) const noexcept requires (
+            std::convertible_to<
+                std::ranges::range_reference_t<Tokens>,
+                std::string_view>)
+        {
+            using View = std::views::all_t<Tokens>;
 
-            auto const disjoint_union = m_positions
-                .disjoint_union(m_optionals)
-                .disjoint_union(m_booleans);
+            return pnk::ctap_events<Arguments, View>(
+                descriptors,
+                std::views::all(std::forward<Tokens>(tokens)));
+        }
 
-            auto const index = disjoint_union.find_if([]<typename T>(T const& a)
-            {
-                return T::is_needed and not a.was_parsed;
-            });
+        // Writes every bound argument which was parsed straight into the
+        // aggregate. The other members are left as they were, so they can be
+        // given default values beforehand. Arguments which aren't bound are
+        // still checked, but their values aren't kept.
+        template <typename Aggregate>
+        auto parse(
+            int                const argc,
+            char const* const* const argv,
+            Aggregate&               aggregate)
+        const noexcept -> void
+        {
+            auto discarded = false;
+            auto targets   = detail::bound_targets<Arguments>::of(
+                aggregate,
+                discarded);
 
-            if (index == decltype(disjoint_union)::npos)
-            {
-                return pnk::ctap_result(std::move(disjoint_union));
-            }
-            else
-            {
-                // TODO: Handle failure.
-                std::exit(64);
-            }
+            parse_targets(argc, argv, targets);
         }
     private:
-        template <bool wordy>
+        // The table lists the arguments in the same order as the disjoint
+        // union of the sets, so the n-th entry describes the n-th argument.
+        auto constexpr static descriptors = detail::concatenate(
+            detail::descriptors_of<
+                detail::argument_kind::position,
+                PositionsTypeSet>::value,
+            detail::descriptors_of<
+                detail::argument_kind::optional,
+                OptionalsTypeSet>::value,
+            detail::descriptors_of<
+                detail::argument_kind::boolean,
+                BooleansTypeSet>::value);
+
         [[nodiscard]]
-        auto constexpr parse_optional(
-            std::string_view   current,
-            char const* const* next_it)
-        noexcept -> std::ptrdiff_t
+        auto parse_arguments(
+            int                const argc,
+            char const* const* const argv)
+        const noexcept
         {
-            auto const hyphen_offset = wordy + 1;
-            auto const equals_index  = current.find('=');
-            auto const npos = BooleansTypeSet::npos;
-            auto const name = equals_index != std::string_view::npos?
-                current.substr(hyphen_offset, equals_index - hyphen_offset) :
-                current.substr(hyphen_offset);
-
-            auto const matches_name = [name]<typename T>(T const&) noexcept
-            {
-                if constexpr (wordy)
-                    return T::wordy == name;
-                else
-                    return T::brief == name;
-            };
-
-            if (auto const i = m_booleans.find_if(matches_name); i != npos)
-            {
-                m_booleans.apply_at(i, [](auto& argument)
-                {
-                    pnk::parse_visitor(argument, {});
-                });
-
-                return 0;
-            }
+            auto arguments = Arguments{};
+            auto targets   = std::array<detail::target, descriptors.size()>{};
 
-            if (auto const i = m_optionals.find_if(matches_name); i != npos)
+            auto i = std::size_t(0);
+            arguments.for_each([&](auto& argument)
             {
-                auto const value = equals_index != std::string_view::npos?
-                    current.substr(equals_index + 1) :
-                    std::string_view(*next_it);
+                targets[i++] = { &argument.value, &argument.was_parsed };
+            });
 
-                m_optionals.apply_at(i, [value](auto& argument)
-                {
-                    pnk::parse_visitor(argument, value);
-                });
+            parse_targets(argc, argv, targets);
 
-                return equals_index == std::string_view::npos;
-            }
-            
-            // TODO: Handle failure.
-            std::exit(64);
+            return arguments;
         }
 
-        auto constexpr parse_position(std::string_view value) noexcept -> void
+        auto parse_targets(
+            int                             const argc,
+            char const* const*              const argv,
+            std::span<detail::target const> const targets)
+        const noexcept -> void
         {
-            auto const npos = PositionsTypeSet::npos;
-            auto const wasnt_parsed = [](auto&& argument) constexpr noexcept
-            {
-                return not argument.was_parsed;
-            };
+            auto parsed = std::array<
+                detail::word,
+                detail::words_for(descriptors.size())>{};
 
-            if (auto const i = m_positions.find_if(wasnt_parsed); i != npos)
-            {
-                m_positions.apply_at(i, [value](auto& argument)
-                {
-                    pnk::parse_visitor(argument, value);
-                });
-            }
-            else
+            if (not detail::parse(descriptors, targets, parsed, argc, argv))
             {
                 // TODO: Handle failure.
                 std::exit(64);
             }
+
+            auto constexpr table = constraints();
+
+            for (auto const& [kind, names, implied] : table)
+            {
+                if (not detail::satisfies(kind, names, implied, parsed))
+                {
+                    // TODO: Handle failure.
+                    std::exit(64);
+                }
+            }
         }
-        
+
         PositionsTypeSet m_positions;
         OptionalsTypeSet m_optionals;
         BooleansTypeSet  m_booleans;
+
+        using Arguments = decltype(m_positions
+            .disjoint_union(m_optionals)
+            .disjoint_union(m_booleans));
+
+        // Names are looked up here rather than in add_constraint, since they
+        // may refer to arguments which are only added later. This has to be a
+        // function: the initializer of a static data member of type auto is
+        // instantiated along with the class, which happens for every parser
+        // returned on the way to the final one.
+        [[nodiscard]]
+        auto consteval static constraints() noexcept
+        {
+            return detail::constraint_table<Arguments, Constraints>::value;
+        }
+
+        // The same parser, but with different sets.
+        template <
+            typename Positions,
+            typename Optionals,
+            typename Booleans>
+        using rebind = pnk::ctap<Positions, Optionals, Booleans, Constraints>;
     }; // struct ctap
 
     // You might've noticed that all add_* functions return a parser. This is
@@ -345,93 +1853,166 @@ namespace pnk
     // But initially, we don't have a previous parser object to call add_* on.
     // Having to spell out even this first parser object's type would be less
     // than ideal because it's complex and reveals more implementation details
-    // than necessary. Instead, we can use this builder struct, which also has
-    // all the same add_* functions, which create a parser with the first arg.
-    struct ctap_builder
+    // than necessary. Instead, we can use this builder struct, which is simply
+    // the parser without any arguments, so it has all the same add_* functions.
+    struct ctap_builder : pnk::ctap<
+        pnk::type_set<detail::argument_comparator>,
+        pnk::type_set<detail::argument_comparator>,
+        pnk::type_set<detail::argument_comparator>>
+    {}; // struct ctap_builder;
+
+    // PROBLEM:
+    // Chaining add_* calls is easy to read, but every call in the chain defines
+    // its own parser type. A parser with N arguments therefore instantiates N
+    // intermediate parsers, each of which the compiler has to check, and with
+    // hundreds of arguments that noticeably slows down the build.
+
+    // Instead, the arguments can be declared all at once:
+    //     auto parser = pnk::make_ctap<
+    //         pnk::position<"file", std::string_view, true>,
+    //         pnk::option  <"j", "jobs", int>,
+    //         pnk::flag    <"v", "verbose">>();
+    // make_ctap sorts the declarations into the three sets and instantiates
+    // only the final parser type.
+    template <
+        pnk::static_string name,
+        typename           T,
+        bool               needed = false>
+    struct position
     {
-    public:
-        template <
-            pnk::static_string name,
-            typename           T,
-            bool               needed = false>
-        constexpr auto add_position() const noexcept
-        {
-            using Argument = pnk::argument<"", name, T, needed>;
-            return pnk::ctap<
-                pnk::type_set<default_argument_comparator, Argument>,
-                pnk::type_set<default_argument_comparator>,
-                pnk::type_set<default_argument_comparator>>{};
-        }
+        using argument = pnk::argument<"", name, T, needed>;
 
-        template <
-            pnk::static_string brief,
-            pnk::static_string wordy,
-            typename           T,
-            bool               needed = false>
-        constexpr auto add_optional() const noexcept requires (
-            not std::is_same_v<T, bool>)
-        {
-            using Argument = pnk::argument<brief, wordy, T, needed>;
-            return pnk::ctap<
-                pnk::type_set<default_argument_comparator>,
-                pnk::type_set<default_argument_comparator, Argument>,
-                pnk::type_set<default_argument_comparator>>{};
-        }
+        auto constexpr static kind = detail::argument_kind::position;
+    };
 
-        template <
-            pnk::static_string wordy,
-            typename           T,
-            bool               needed = false>
-        constexpr auto add_optional() const noexcept requires (
-            not std::is_same_v<T, bool>)
-        {
-            using Argument = pnk::argument<"", wordy, T, needed>;
-            return pnk::ctap<
-                pnk::type_set<default_argument_comparator>,
-                pnk::type_set<default_argument_comparator, Argument>,
-                pnk::type_set<default_argument_comparator>>{};
-        }
+    // Like add_optional, an option of type bool is a boolean flag.
+    template <
+        pnk::static_string brief,
+        pnk::static_string wordy,
+        typename           T,
+        bool               needed = false>
+    struct option
+    {
+        using argument = pnk::argument<brief, wordy, T, needed>;
 
-        template <
-            pnk::static_string brief,
-            pnk::static_string wordy,
-            typename           T,
-            bool               needed = false>
-        constexpr auto add_optional() const noexcept requires (
-            std::is_same_v<T, bool>)
-        {
-            using Argument = pnk::argument<brief, wordy, bool, needed>;
-            return pnk::ctap<
-                pnk::type_set<default_argument_comparator>,
-                pnk::type_set<default_argument_comparator>,
-                pnk::type_set<default_argument_comparator, Argument>>{};
-        }
+        auto constexpr static kind = std::is_same_v<T, bool>?
+            detail::argument_kind::boolean :
+            detail::argument_kind::optional;
+    };
 
-        template <
-            pnk::static_string wordy,
-            typename           T,
-            bool               needed = false>
-        constexpr auto add_optional() const noexcept requires (
-            std::is_same_v<T, bool>)
-        {
-            using Argument = pnk::argument<"", wordy, bool, needed>;
-            return pnk::ctap<
-                pnk::type_set<default_argument_comparator>,
-                pnk::type_set<default_argument_comparator>,
-                pnk::type_set<default_argument_comparator, Argument>>{};
-        }
+    template <
+        pnk::static_string brief,
+        pnk::static_string wordy,
+        bool               needed = false>
+    struct flag
+    {
+        using argument = pnk::argument<brief, wordy, bool, needed>;
 
-    private:
-        template <
-            typename Lhs,
-            typename Rhs>
-        struct default_argument_comparator : std::bool_constant<
-            Lhs::wordy == Rhs::wordy or
-            (not Rhs::brief.empty() and Lhs::wordy == Rhs::brief) or
-            (not Lhs::brief.empty() and Lhs::brief == Rhs::wordy) or
-            (not Lhs::brief.empty() and Lhs::brief == Rhs::brief)>
-        {};
-    }; // struct ctap_builder;
+        auto constexpr static kind = detail::argument_kind::boolean;
+    };
+
+    template <
+        pnk::static_string name,
+        auto               member,
+        bool               needed = false>
+    struct bound_position
+    {
+        using argument = detail::bound_argument<"", name, member, needed>;
+
+        auto constexpr static kind = detail::argument_kind::position;
+    };
+
+    template <
+        pnk::static_string brief,
+        pnk::static_string wordy,
+        auto               member,
+        bool               needed = false>
+    struct bound_option
+    {
+        using argument = detail::bound_argument<brief, wordy, member, needed>;
+
+        auto constexpr static kind = std::is_same_v<
+            typename argument::type,
+            bool>?
+            detail::argument_kind::boolean :
+            detail::argument_kind::optional;
+    };
+
+    template <
+        pnk::static_string name,
+        bool               needed = false>
+    struct passthrough
+    {
+        using argument = pnk::argument<"--", name, pnk::argv_span, needed>;
+
+        auto constexpr static kind = detail::argument_kind::position;
+    };
+
+    // Constraints can be declared along with the arguments, or added to a
+    // parser with add_constraint. See detail::constraint_kind.
+    template <pnk::static_string... names>
+    struct exclusive
+    {
+        static_assert(sizeof...(names) > 1, "Nothing to exclude.");
+
+        auto constexpr static constraint = detail::constraint_kind::exclusive;
+
+        template <typename Arguments>
+        auto constexpr static masks = detail::constraint_masks<
+            detail::words_for(Arguments::size)>{
+                .kind    = constraint,
+                .names   = detail::mask_of<Arguments, names...>(),
+                .implied = {},
+            };
+    };
+
+    template <pnk::static_string... names>
+    struct at_least_one
+    {
+        static_assert(sizeof...(names) > 0, "Nothing to require.");
+
+        auto constexpr static constraint =
+            detail::constraint_kind::at_least_one;
+
+        template <typename Arguments>
+        auto constexpr static masks = detail::constraint_masks<
+            detail::words_for(Arguments::size)>{
+                .kind    = constraint,
+                .names   = detail::mask_of<Arguments, names...>(),
+                .implied = {},
+            };
+    };
+
+    template <
+        pnk::static_string    name,
+        pnk::static_string... implied>
+    struct implies
+    {
+        static_assert(sizeof...(implied) > 0, "Nothing is implied.");
+
+        auto constexpr static constraint = detail::constraint_kind::implies;
+
+        template <typename Arguments>
+        auto constexpr static masks = detail::constraint_masks<
+            detail::words_for(Arguments::size)>{
+                .kind    = constraint,
+                .names   = detail::mask_of<Arguments, name>(),
+                .implied = detail::mask_of<Arguments, implied...>(),
+            };
+    };
+
+    template <typename... Declarations>
+    [[nodiscard]]
+    auto constexpr make_ctap() noexcept
+    {
+        using detail::argument_kind;
+
+        return pnk::ctap<
+            detail::arguments_of<argument_kind::position, Declarations...>,
+            detail::arguments_of<argument_kind::optional, Declarations...>,
+            detail::arguments_of<argument_kind::boolean,  Declarations...>,
+            detail::constraints_of<Declarations...>>{};
+    }
 } // namespace pnk
 
 #endif // PNK_CTAP_HPP
@@ -453,6 +2034,7 @@ namespace pnk
 // References:
 // [1] https://open-std.org/JTC1/SC22/WG14/www/docs/n3096.pdf#paragraph.5.1.2.2.1.2
 // [2] https://en.wikipedia.org/wiki/Command-line_interface#Arguments
+// [3] https://www.unicode.org/versions/latest/ch03.pdf
 
 // MIT License
 // Copyright (c) Hrvoje "Hurubon" Žohar
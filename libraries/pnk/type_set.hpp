@@ -9,37 +9,39 @@
 #include <functional>
 #include <type_traits>
 
-namespace
+namespace pnk
 {
-    template <std::size_t i>
-    using constant = std::integral_constant<decltype(i), i>;
+    // NOTE:
+    // Templates exported from the pnk.ctap module may not refer to entities
+    // with internal linkage, so these helpers can't be in an anonymous
+    // namespace.
+    namespace detail
+    {
+        template <std::size_t i>
+        using constant = std::integral_constant<decltype(i), i>;
 
-    template <
         template <
-            typename,
-            typename>
-        typename    Comparator,
-        typename... Arguments>
-    struct contains_duplicates : std::false_type
-    {};
+            template <
+                typename,
+                typename>
+            typename    Comparator,
+            typename... Arguments>
+        struct contains_duplicates : std::false_type
+        {};
 
-    template <
         template <
-            typename,
-            typename>
-        typename    Comparator,
-        typename    Head,
-        typename... Tail>
-    struct contains_duplicates<Comparator, Head, Tail...> : std::disjunction<
-        std::disjunction<Comparator<Head, Tail>...>,
-        contains_duplicates<Comparator, Tail...>>
-    {};
-}
+            template <
+                typename,
+                typename>
+            typename    Comparator,
+            typename    Head,
+            typename... Tail>
+        struct contains_duplicates<Comparator, Head, Tail...>
+            : std::disjunction<
+                std::disjunction<Comparator<Head, Tail>...>,
+                contains_duplicates<Comparator, Tail...>>
+        {};
 
-namespace pnk
-{
-    namespace detail
-    {
         template <
             std::size_t current,
             template <
@@ -93,7 +95,7 @@ namespace pnk
             : m_data{ data }
         {
             static_assert(
-                not contains_duplicates<Comparator, Arguments...>(),
+                not detail::contains_duplicates<Comparator, Arguments...>(),
                 "Cannot create a set with duplicate keys.");
         }
         [[nodiscard]]
@@ -101,7 +103,7 @@ namespace pnk
             : m_data{ data }
         {
             static_assert(
-                not contains_duplicates<Comparator, Arguments...>(),
+                not detail::contains_duplicates<Comparator, Arguments...>(),
                 "Cannot create a set with duplicate keys.");
         }
 
@@ -111,7 +113,9 @@ namespace pnk
             Predicate&& predicate)
         const noexcept -> std::size_t
         {
-            auto const loop = [&]<std::size_t i>(auto&& self, constant<i>)
+            auto const loop = [&]<std::size_t i>(
+                auto&&              self,
+                detail::constant<i>)
             {
                 if constexpr (i == sizeof...(Arguments))
                 {
@@ -128,11 +132,11 @@ namespace pnk
                         }
                     }
 
-                    return self(self, constant<i + 1>{});
+                    return self(self, detail::constant<i + 1>{});
                 }
             };
 
-            return loop(loop, constant<0>{});
+            return loop(loop, detail::constant<0>{});
         }
 
         template <typename Function>
@@ -141,7 +145,9 @@ namespace pnk
             Function&&  function)
         noexcept -> void
         {
-            auto const loop = [&]<std::size_t i>(auto&& self, constant<i>)
+            auto const loop = [&]<std::size_t i>(
+                auto&&              self,
+                detail::constant<i>)
             {
                 if constexpr (i == sizeof...(Arguments))
                 {
@@ -159,11 +165,11 @@ namespace pnk
                         }
                     }
 
-                    self(self, constant<i + 1>{});
+                    self(self, detail::constant<i + 1>{});
                 }
             };
 
-            loop(loop, constant<0>{});
+            loop(loop, detail::constant<0>{});
         }
 
         template <typename Function>
@@ -172,7 +178,9 @@ namespace pnk
             Function&&  function)
         const noexcept -> void
         {
-            auto const loop = [&]<std::size_t i>(auto&& self, constant<i>)
+            auto const loop = [&]<std::size_t i>(
+                auto&&              self,
+                detail::constant<i>)
             {
                 if constexpr (i == sizeof...(Arguments))
                 {
@@ -190,11 +198,33 @@ namespace pnk
                         }
                     }
 
-                    self(self, constant<i + 1>{});
+                    self(self, detail::constant<i + 1>{});
                 }
             };
 
-            loop(loop, constant<0>{});
+            loop(loop, detail::constant<0>{});
+        }
+
+        template <typename Function>
+        auto constexpr for_each(
+            Function&& function)
+        noexcept -> void
+        {
+            std::apply([&](Arguments&... arguments)
+            {
+                (std::invoke(function, arguments), ...);
+            }, m_data);
+        }
+
+        template <typename Function>
+        auto constexpr for_each(
+            Function&& function)
+        const noexcept -> void
+        {
+            std::apply([&](Arguments const&... arguments)
+            {
+                (std::invoke(function, arguments), ...);
+            }, m_data);
         }
 
         template <typename... Others>
@@ -245,9 +275,6 @@ namespace pnk
             return std::get<i>(m_data);
         }
 
-    auto constexpr static npos = static_cast<std::size_t>(-1);
-
-    private:
         template <typename ToFind>
         [[nodiscard]]
         auto consteval static index_of() noexcept -> std::size_t
@@ -255,6 +282,10 @@ namespace pnk
             return detail::index_of<0, Comparator, ToFind, Arguments...>::value;
         }
 
+    auto constexpr static npos = static_cast<std::size_t>(-1);
+    auto constexpr static size = sizeof...(Arguments);
+
+    private:
         std::tuple<Arguments...> m_data;
     }; // struct type_set
 } // namespace pnk
@@ -0,0 +1,36 @@
+// Copyright (c) Hrvoje "Hurubon" Žohar
+// See LICENSE for copyright information.
+
+// Uses the library only through the pnk.ctap module. If any public name isn't
+// exported, this doesn't compile, and the pnk-ctap-module-importer test runs
+// it to check that a parser built through the module also parses.
+
+import pnk.ctap;
+
+#include <cstdio>
+
+auto main(int const argc, char const* const* const argv) -> int
+{
+    using check = pnk::text_check;
+    using path  = pnk::validated<check::utf8 | check::path>;
+
+    auto const parser = pnk::make_ctap<
+        pnk::flag        <"v", "verbose">,
+        pnk::flag        <"q", "quiet">,
+        pnk::option      <"j", "jobs",   int>,
+        pnk::option      <"o", "output", path>,
+        pnk::position    <"files", pnk::argv_span>,
+        pnk::passthrough <"child">,
+        pnk::exclusive   <"verbose", "quiet">>();
+
+    auto const result = parser.parse(argc, argv);
+    auto const output = result.get<"output">();
+
+    std::printf("v=%d j=%d output=%.*s files=%zu child=%zu\n",
+        static_cast<int>(result.get<"v">()),
+        result.get<"j">(),
+        static_cast<int>(output.size()),
+        output.data(),
+        result.get<"files">().size(),
+        result.get<"child">().size());
+}
@@ -0,0 +1,78 @@
+// Copyright (c) Hrvoje "Hurubon" Žohar
+// See end of file for extended copyright information.
+
+// PROBLEM:
+// ctap.hpp includes <charconv>, <tuple>, <functional> and <concepts>, as well
+// as static_string.hpp and type_set.hpp. Every translation unit including it
+// has to parse all of them again. A module interface unit is parsed once and
+// then imported by every translation unit which needs it:
+//     import pnk.ctap;
+
+// The header stays the single source of truth. It is included in the global
+// module fragment and this unit only exports the public names. Everything in
+// pnk::detail is still reachable through the exported templates, but it can't
+// be named by importers.
+
+module;
+
+#include <pnk/ctap.hpp>
+
+export module pnk.ctap;
+
+export namespace pnk
+{
+    // static_string.hpp
+    using pnk::static_string;
+    using pnk::operator==;
+
+    // type_set.hpp
+    using pnk::type_set;
+
+    // ctap.hpp
+    using pnk::argv_span;
+    using pnk::text_check;
+    using pnk::operator|;
+    using pnk::validated;
+    using pnk::argument;
+    using pnk::bound_argument;
+    using pnk::parse_visitor;
+    using pnk::ctap_result;
+    using pnk::serialize;
+    using pnk::deserialize;
+    using pnk::event_kind;
+    using pnk::ctap_event;
+    using pnk::ctap_events;
+    using pnk::ctap;
+    using pnk::ctap_builder;
+    using pnk::position;
+    using pnk::option;
+    using pnk::flag;
+    using pnk::bound_position;
+    using pnk::bound_option;
+    using pnk::passthrough;
+    using pnk::exclusive;
+    using pnk::at_least_one;
+    using pnk::implies;
+    using pnk::make_ctap;
+} // namespace pnk
+
+// MIT License
+// Copyright (c) Hrvoje "Hurubon" Žohar
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
@@ -0,0 +1,17 @@
+# Runs FIRST and SECOND and checks that they print the same thing.
+foreach (program IN ITEMS FIRST SECOND)
+    execute_process(
+        COMMAND         ${${program}}
+        RESULT_VARIABLE exit
+        OUTPUT_VARIABLE ${program}_OUTPUT)
+
+    if (NOT exit EQUAL 0)
+        message(FATAL_ERROR "${${program}} exited with ${exit}")
+    endif()
+endforeach()
+
+if (NOT FIRST_OUTPUT STREQUAL SECOND_OUTPUT)
+    message(FATAL_ERROR
+        "${FIRST} printed\n    ${FIRST_OUTPUT}\n"
+        "${SECOND} printed\n    ${SECOND_OUTPUT}")
+endif()
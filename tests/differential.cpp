@@ -0,0 +1,114 @@
+// Copyright (c) Hrvoje "Hurubon" Žohar
+// See LICENSE for copyright information.
+
+// Classifies and validates the same pseudo-random tokens as every other build
+// of this file and prints a hash of the results. It's built once with SIMD and once with
+// PNK_CTAP_DISABLE_SIMD, and the two have to print the same thing.
+
+// The tokens are placed at every alignment, and followed by bytes which look
+// like parts of a token, since the vectorized version reads past their ends.
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <pnk/ctap.hpp>
+
+namespace
+{
+    auto constexpr token_count = 2'000'000;
+    auto constexpr text_count  =   500'000; // Each is validated 7 times.
+    auto constexpr max_size    = 100;
+
+    // Bytes which change how a token is classified are more likely.
+    auto constexpr alphabet = std::to_array<char>({
+        '-', '-', '=', '=', 'a', 'b', '/', '.', '\0',
+    });
+
+    // Lead and continuation bytes of UTF-8 at the edges of what's allowed,
+    // control characters and what ".." components are made of.
+    auto constexpr text_alphabet = std::to_array<unsigned char>({
+        'a',  'b',  '.',  '.',  '/',  '\\', 0x1F, 0x7F, 0xC0, 0xC2, 0xDF,
+        0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0x80, 0x8F, 0x90, 0x9F, 0xA0,
+        0xBF,
+    });
+
+    struct hash
+    {
+        std::uint64_t value = 14695981039346656037u;
+
+        auto add(std::uint64_t const data) noexcept -> void
+        {
+            value = (value ^ data) * 1099511628211u;
+        }
+    };
+} // namespace
+
+auto main() -> int
+{
+    // std::mt19937 is the same everywhere, unlike the distributions.
+    auto random = std::mt19937(2024);
+    auto result = hash{};
+
+    alignas(16) auto buffer = std::array<char, 256>{};
+
+    for (auto i = 0; i < token_count; ++i)
+    {
+        auto const offset = random() % 32;
+        auto const size   = random() % max_size;
+
+        // Enough bytes after the token for the last load to read them. Each
+        // random number picks four of them.
+        for (auto j = std::size_t(0); j < offset + size + 32; j += 4)
+        {
+            auto const bits = random();
+
+            for (auto k = std::size_t(0); k < 4; ++k)
+            {
+                auto const byte = bits >> 8 * k & 0xFF;
+                buffer[j + k]   = alphabet[byte % alphabet.size()];
+            }
+        }
+
+        for (auto j = std::size_t(0); j < size; ++j)
+            if (buffer[offset + j] == '\0')
+                buffer[offset + j] = 'c';
+
+        buffer[offset + size] = '\0';
+
+        auto const type = pnk::detail::classify(buffer.data() + offset);
+
+        result.add(type.size);
+        result.add(type.equals);
+        result.add(type.dashes);
+    }
+
+    for (auto i = 0; i < text_count; ++i)
+    {
+        auto const offset = random() % 16;
+        auto const size   = random() % max_size;
+
+        // Mostly ASCII, so that runs of 16 ASCII bytes are common.
+        for (auto j = std::size_t(0); j < size; ++j)
+        {
+            auto const bits = random();
+            buffer[offset + j] = bits % 3 != 0?
+                static_cast<char>('a' + bits / 3 % 26) :
+                static_cast<char>(
+                    text_alphabet[bits / 3 % text_alphabet.size()]);
+        }
+
+        auto const text = std::string_view(buffer.data() + offset, size);
+
+        for (auto checks = 1u; checks < 8; ++checks)
+            result.add(pnk::detail::is_valid(text, pnk::text_check(checks)));
+    }
+
+    std::printf("tokens=%d texts=%d hash=%016llx\n",
+        token_count,
+        text_count,
+        static_cast<unsigned long long>(result.value));
+}
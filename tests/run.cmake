@@ -0,0 +1,29 @@
+# Runs PROGRAM with the arguments after "--" and checks that it exits with
+# EXPECTED_EXIT and prints EXPECTED_OUTPUT. The arguments are passed this way
+# so that ones starting with a hyphen aren't taken by CMake.
+set(arguments)
+set(found FALSE)
+
+math(EXPR last "${CMAKE_ARGC} - 1")
+foreach (i RANGE ${last})
+    if (found)
+        list(APPEND arguments "${CMAKE_ARGV${i}}")
+    elseif ("${CMAKE_ARGV${i}}" STREQUAL "--")
+        set(found TRUE)
+    endif()
+endforeach()
+
+execute_process(
+    COMMAND         ${PROGRAM} ${arguments}
+    RESULT_VARIABLE exit
+    OUTPUT_VARIABLE output
+    OUTPUT_STRIP_TRAILING_WHITESPACE)
+
+if (NOT exit EQUAL EXPECTED_EXIT)
+    message(FATAL_ERROR "Exited with ${exit} instead of ${EXPECTED_EXIT}")
+endif()
+
+if (NOT output STREQUAL EXPECTED_OUTPUT)
+    message(FATAL_ERROR
+        "Printed\n    ${output}\ninstead of\n    ${EXPECTED_OUTPUT}")
+endif()
@@ -0,0 +1,287 @@
+// Copyright (c) Hrvoje "Hurubon" Žohar
+// See LICENSE for copyright information.
+
+// Parses its command line with the parser named by the first argument and
+// prints what it parsed on one line. The checks are in CMakeLists.txt, since
+// a failed parse exits the program.
+
+#include <array>
+#include <cstdio>
+#include <cstddef>
+#include <string_view>
+
+#include <pnk/ctap.hpp>
+
+namespace
+{
+    auto print(std::string_view const text) -> void
+    {
+        std::printf("%.*s", static_cast<int>(text.size()), text.data());
+    }
+
+    auto print(pnk::argv_span const span) -> void
+    {
+        for (auto i = std::size_t(0); i < span.size(); ++i)
+        {
+            if (i != 0)
+                print(",");
+
+            print(span[i]);
+        }
+    }
+
+    auto rest(int const argc, char const* const* const argv) -> int
+    {
+        auto const parser = pnk::make_ctap<
+            pnk::flag    <"v", "verbose">,
+            pnk::option  <"j", "jobs",  int>,
+            pnk::position<"files", pnk::argv_span>>();
+
+        auto const result = parser.parse(argc, argv);
+
+        std::printf("v=%d j=%d files=",
+            static_cast<int>(result.get<"v">()),
+            result.get<"j">());
+        print(result.get<"files">());
+
+        return 0;
+    }
+
+    auto print_passthrough(auto const& result) -> void
+    {
+        print("first=");
+        print(result.template get<"first">());
+        std::printf(" j=%d files=", result.template get<"j">());
+        print(result.template get<"files">());
+        print(" child=");
+        print(result.template get<"child">());
+    }
+
+    auto passthrough(int const argc, char const* const* const argv) -> int
+    {
+        auto const parser = pnk::make_ctap<
+            pnk::position   <"first", std::string_view, true>,
+            pnk::option     <"j", "jobs", int>,
+            pnk::position   <"files", pnk::argv_span>,
+            pnk::passthrough<"child">>();
+
+        print_passthrough(parser.parse(argc, argv));
+
+        return 0;
+    }
+
+    // The same parser as passthrough, built by chaining.
+    auto builder_passthrough(
+        int                const argc,
+        char const* const* const argv)
+    -> int
+    {
+        auto const parser = pnk::ctap_builder{}
+            .add_position   <"first", std::string_view, true>()
+            .add_optional   <"j", "jobs", int>()
+            .add_position   <"files", pnk::argv_span>()
+            .add_passthrough<"child">();
+
+        print_passthrough(parser.parse(argc, argv));
+
+        return 0;
+    }
+
+    struct config
+    {
+        std::string_view file;
+        int              jobs    = 1;
+        bool             verbose = false;
+        double           ratio   = 0.5;
+        pnk::argv_span   rest;
+    };
+
+    // Prints a copy of the config made by serializing it and deserializing
+    // it again.
+    auto print_config(config const& parsed) -> void
+    {
+        auto const bytes = pnk::serialize(parsed);
+        auto const copy  = pnk::deserialize<config>(bytes);
+
+        print("file=");
+        print(copy.file);
+        std::printf(" j=%d v=%d ratio=%g rest=",
+            copy.jobs,
+            static_cast<int>(copy.verbose),
+            copy.ratio);
+        print(copy.rest);
+    }
+
+    auto bound(int const argc, char const* const* const argv) -> int
+    {
+        auto const parser = pnk::make_ctap<
+            pnk::bound_position<"file", &config::file, true>,
+            pnk::bound_option  <"j", "jobs",    &config::jobs>,
+            pnk::bound_option  <"v", "verbose", &config::verbose>,
+            pnk::bound_option  <"",  "ratio",   &config::ratio>,
+            pnk::bound_position<"rest", &config::rest>>();
+
+        auto parsed = config{};
+        parser.parse(argc, argv, parsed);
+
+        print_config(parsed);
+
+        return 0;
+    }
+
+    // The same parser as bound, built by chaining, along with an extra
+    // argument which isn't bound to anything.
+    auto builder_bound(int const argc, char const* const* const argv) -> int
+    {
+        auto const parser = pnk::ctap_builder{}
+            .add_position<"file", &config::file, true>()
+            .add_optional<"j", "jobs",    &config::jobs>()
+            .add_optional<"v", "verbose", &config::verbose>()
+            .add_optional<"ratio",        &config::ratio>()
+            .add_optional<"x", "extra",   int>()
+            .add_position<"rest", &config::rest>();
+
+        auto parsed = config{};
+        parser.parse(argc, argv, parsed);
+
+        print_config(parsed);
+
+        return 0;
+    }
+
+    auto print_constraints(auto const& result) -> void
+    {
+        std::printf("d=%d f=%d key=",
+            static_cast<int>(result.template get<"d">()),
+            static_cast<int>(result.template get<"f">()));
+        print(result.template get<"tls-key">());
+        print(" cert=");
+        print(result.template get<"tls-cert">());
+    }
+
+    auto constraints(int const argc, char const* const* const argv) -> int
+    {
+        auto const parser = pnk::make_ctap<
+            pnk::flag        <"d", "daemon">,
+            pnk::flag        <"f", "foreground">,
+            pnk::option      <"", "tls-key",  std::string_view>,
+            pnk::option      <"", "tls-cert", std::string_view>,
+            pnk::exclusive   <"daemon", "f">,
+            pnk::at_least_one<"d", "foreground">,
+            pnk::implies     <"tls-key", "tls-cert">>();
+
+        print_constraints(parser.parse(argc, argv));
+
+        return 0;
+    }
+
+    // The same parser as constraints, built by chaining. The constraints are
+    // added before the arguments they name.
+    auto builder_constraints(
+        int                const argc,
+        char const* const* const argv)
+    -> int
+    {
+        auto const parser = pnk::ctap_builder{}
+            .add_constraint<pnk::exclusive   <"daemon", "f">>()
+            .add_constraint<pnk::at_least_one<"d", "foreground">>()
+            .add_constraint<pnk::implies     <"tls-key", "tls-cert">>()
+            .add_optional  <"d", "daemon",     bool>()
+            .add_optional  <"f", "foreground", bool>()
+            .add_optional  <"tls-key",  std::string_view>()
+            .add_optional  <"tls-cert", std::string_view>();
+
+        print_constraints(parser.parse(argc, argv));
+
+        return 0;
+    }
+
+    // An invalid value isn't parsed, so "output" is then left empty.
+    auto validated(int const argc, char const* const* const argv) -> int
+    {
+        using check = pnk::text_check;
+
+        auto const parser = pnk::make_ctap<
+            pnk::position<"name",
+                pnk::validated<check::utf8 | check::control>, true>,
+            pnk::option  <"o", "output",
+                pnk::validated<check::utf8 | check::control | check::path>>>();
+
+        auto const result = parser.parse(argc, argv);
+
+        print("name=");
+        print(result.get<"name">());
+        print(" output=");
+        print(result.get<"output">());
+
+        return 0;
+    }
+
+    // Prints each event as its kind and token, and the value of "jobs".
+    auto events(int const argc, char const* const* const argv) -> int
+    {
+        auto constexpr kinds = std::to_array<std::string_view>({
+            "optional",
+            "position",
+            "unknown",
+            "invalid",
+        });
+
+        auto const parser = pnk::make_ctap<
+            pnk::position   <"first", int>,
+            pnk::option     <"j", "jobs", int>,
+            pnk::flag       <"v", "verbose">,
+            pnk::position   <"files", pnk::argv_span>,
+            pnk::passthrough<"child">>();
+
+        // Unlike parse, events doesn't skip the first token.
+        auto const tokens = pnk::argv_span(argv + 1, argv + argc);
+
+        for (auto const& event : parser.events(tokens))
+        {
+            print(kinds[static_cast<std::size_t>(event.kind())]);
+            print(":");
+            print(event.token());
+
+            if (event.kind() == pnk::event_kind::optional and
+                event.is<"jobs">())
+            {
+                std::printf("=%d", event.get<"jobs">());
+            }
+
+            print(" ");
+        }
+
+        return 0;
+    }
+} // namespace
+
+auto main(int const argc, char const* const* const argv) -> int
+{
+    if (argc < 2)
+        return 1;
+
+    // The parsers skip the name of the test, as if it were the program's.
+    auto const test = std::string_view(argv[1]);
+
+    if (test == "rest")
+        return rest(argc - 1, argv + 1);
+    else if (test == "passthrough")
+        return passthrough(argc - 1, argv + 1);
+    else if (test == "builder-passthrough")
+        return builder_passthrough(argc - 1, argv + 1);
+    else if (test == "bound")
+        return bound(argc - 1, argv + 1);
+    else if (test == "builder-bound")
+        return builder_bound(argc - 1, argv + 1);
+    else if (test == "constraints")
+        return constraints(argc - 1, argv + 1);
+    else if (test == "builder-constraints")
+        return builder_constraints(argc - 1, argv + 1);
+    else if (test == "validated")
+        return validated(argc - 1, argv + 1);
+    else if (test == "events")
+        return events(argc - 1, argv + 1);
+
+    return 1;
+}